@@ -0,0 +1,420 @@
+#pragma once
+
+#include <vector>
+#include <iostream>
+
+// Partially persistent red-black tree without parent pointers. Insert and
+// Remove keep the root-to-node path on an explicit stack, so nodes only log
+// Left, Right and Color modifications and have no return pointers. When a
+// node runs out of modifications it is copied and, at the end of the
+// operation, its parent is found again by key and relinked to the copy.
+// Keys are expected to be unique, inserting a present key only creates a
+// new version.
+class PathRBTree {
+public:
+	inline PathRBTree() {
+		m_Roots.reserve(100);
+		m_Roots.emplace_back(nullptr, 0);
+	}
+
+	class Node {
+	public:
+		enum class Color { Black, Red };
+
+		class Modification {
+		public:
+			union Field {
+				Color TheColor;
+				Node* Pointer;
+
+				inline Field() : Pointer(nullptr) {}
+				inline Field(Node* pointer) : Pointer(pointer) {}
+				inline Field(Color color) : TheColor(color) {}
+			};
+
+			enum class Type { Left, Right, Color };
+
+			Modification() = default;
+			Modification(Type fieldType, Field field, int version) : FieldType(fieldType), Version(version), TheField(field) {}
+
+		public:
+			Type FieldType;
+			int Version;
+			Field TheField;
+		};
+
+		inline Node(int data, Color color) : Data(data), m_Color(color) {}
+		inline Node(int data, Color color, Node* left, Node* right)
+			: Data(data), m_Left(left), m_Right(right), m_Color(color)
+		{
+		}
+		static constexpr int ModificationsLimit = 6;
+
+		inline bool IsRed(int version = INT32_MAX) const { return GetColor(version) == Color::Red; }
+		inline bool IsBlack(int version = INT32_MAX) const { return GetColor(version) == Color::Black; }
+		inline Color GetColor(int version = INT32_MAX) const { return GetField(Modification::Type::Color, version).TheColor; }
+
+		inline Node* Left(int version = INT32_MAX) const { return GetField(Modification::Type::Left, version).Pointer; }
+		inline Node* Right(int version = INT32_MAX) const { return GetField(Modification::Type::Right, version).Pointer; }
+		inline Node* Child(bool left, int version = INT32_MAX) const { return left ? Left(version) : Right(version); }
+
+		// The setters return true when the node had to be copied.
+		inline bool SetColor(Color color, int version) { return MakeModification(Modification::Type::Color, color, version); }
+		inline bool SetChild(bool left, Node* child, int version) {
+			return MakeModification(left ? Modification::Type::Left : Modification::Type::Right, child, version);
+		}
+
+		inline Node* Latest() {
+			Node* node = this;
+			while (node->m_Next)
+				node = node->m_Next;
+
+			return node;
+		}
+
+	private:
+		inline Modification::Field GetField(Modification::Type fieldType, int version) const {
+			if (m_Next && LatestVersion() <= version)
+				return m_Next->GetField(fieldType, version);
+
+			for (int i = m_ModsCount - 1; i >= 0; i--) {
+				if (m_Mods[i].Version <= version && m_Mods[i].FieldType == fieldType)
+					return m_Mods[i].TheField;
+			}
+
+			switch (fieldType)
+			{
+			case Modification::Type::Left:
+				return m_Left;
+			case Modification::Type::Right:
+				return m_Right;
+			case Modification::Type::Color:
+				return m_Color;
+			default:
+				throw std::runtime_error("Field type not found, GetField");
+			}
+		}
+
+		inline bool MakeModification(Modification::Type fieldType, Modification::Field field, int version) {
+			if (m_Next)
+				return m_Next->MakeModification(fieldType, field, version);
+
+			for (int i = m_ModsCount - 1; i >= 0 && m_Mods[i].Version == version; i--) {
+				if (m_Mods[i].FieldType == fieldType) {
+					m_Mods[i].TheField = field;
+					return false;
+				}
+			}
+
+			m_Mods[m_ModsCount++] = Modification(fieldType, field, version);
+			if (m_ModsCount < ModificationsLimit)
+				return false;
+
+			m_Next = new Node(Data, GetColor(), Left(), Right());
+			return true;
+		}
+
+		inline int LatestVersion() const { return m_Mods[m_ModsCount - 1].Version; }
+
+	public:
+		int Data;
+
+	private:
+		Node* m_Left{ nullptr };
+		Node* m_Right{ nullptr };
+
+		Color m_Color;
+
+		// Same limit and inline storage as RBTree::Node, so the two engines
+		// differ only in the parent pointers.
+		Modification m_Mods[ModificationsLimit];
+		int m_ModsCount{ 0 };
+
+		Node* m_Next{ nullptr };
+	};
+
+	inline Node* Search(int data, int version = INT32_MAX) const {
+		Node* current = Root(version);
+		while (current && current->Data != data)
+			current = data < current->Data ? current->Left(version) : current->Right(version);
+
+		return current;
+	}
+
+	inline int Successor(int data, int version = INT32_MAX) const {
+		int sucessor = INT32_MAX;
+
+		Node* current = Root(version);
+		while (current) {
+			int currData = current->Data;
+			sucessor = currData > data && currData < sucessor ? currData : sucessor;
+			current = data < currData ? current->Left(version) : current->Right(version);
+		}
+
+		return sucessor;
+	}
+	inline void Print(int version = INT32_MAX) const {
+		Node* root = Root(version);
+		if (!root)
+			return;
+		std::cout << root->Data << (root->IsBlack(version) ? " (B)" : " (R)") << std::endl;
+
+		PrintHelper(root->Right(version), 8, version, false);
+		PrintHelper(root->Left(version), 8, version, true);
+	}
+
+	inline void FPrint(int version, std::ostream& outFileStream) const {
+		FPrintHelper(Root(version), version, 0, outFileStream);
+		outFileStream << '\n';
+	}
+
+	inline int CurrentVersion() const { return m_CurrentVersion; }
+
+	inline void Insert(int key) {
+		m_CurrentVersion++;
+
+		m_Path.clear();
+		for (Node* current = Root(); current; current = current->Child(key < current->Data)) {
+			if (current->Data == key)
+				return;
+			m_Path.push_back(current);
+		}
+
+		Node* newNode = new Node(key, Node::Color::Red);
+		ReplaceChild(m_Path.empty() ? nullptr : m_Path.back(), key, newNode);
+		m_Path.push_back(newNode);
+
+		InsertFixup();
+		RelinkCopies();
+	}
+
+	inline void Remove(int key) {
+		m_Path.clear();
+		Node* node = Root();
+		while (node && node->Data != key) {
+			m_Path.push_back(node);
+			node = node->Child(key < node->Data);
+		}
+		if (!node)
+			return;
+
+		m_CurrentVersion++;
+
+		Node* parent = m_Path.empty() ? nullptr : m_Path.back();
+		Node* movedUpNode;
+		bool deletedNodeWasBlack;
+		if (!node->Left() || !node->Right()) {
+			deletedNodeWasBlack = node->IsBlack();
+			movedUpNode = node->Left() ? node->Left() : node->Right();
+			ReplaceChild(parent, key, movedUpNode);
+		} else {
+			std::size_t nodeIndex = m_Path.size();
+			m_Path.push_back(node);
+
+			Node* successor = node->Right();
+			while (successor->Left()) {
+				m_Path.push_back(successor);
+				successor = successor->Left();
+			}
+
+			movedUpNode = successor->Right();
+			if (m_Path.back() != node) {
+				SetChild(m_Path.back(), true, movedUpNode);
+				SetChild(successor, false, node->Right());
+			}
+			SetChild(successor, true, node->Left());
+			ReplaceChild(parent, key, successor);
+
+			deletedNodeWasBlack = successor->IsBlack();
+			SetColor(successor, node->GetColor());
+
+			m_Path[nodeIndex] = successor;
+		}
+
+		if (deletedNodeWasBlack)
+			RemoveFixup(movedUpNode);
+
+		RelinkCopies();
+	}
+
+private:
+	// m_Path holds the ancestors of the node being fixed, from the root down
+	// to its parent, and is kept in sync with the rotations.
+	inline void InsertFixup() {
+		std::size_t index = m_Path.size() - 1;
+		while (index >= 2 && m_Path[index - 1]->IsRed()) {
+			Node* node = m_Path[index];
+			Node* parent = m_Path[index - 1];
+			Node* grandParent = m_Path[index - 2];
+			Node* greatGrandParent = index >= 3 ? m_Path[index - 3] : nullptr;
+
+			bool parentIsLeft = parent->Data < grandParent->Data;
+			Node* uncle = grandParent->Child(!parentIsLeft);
+			if (uncle && uncle->IsRed()) {
+				SetColor(parent, Node::Color::Black);
+				SetColor(uncle, Node::Color::Black);
+				SetColor(grandParent, Node::Color::Red);
+
+				index -= 2;
+				continue;
+			}
+
+			if ((node->Data < parent->Data) != parentIsLeft) {
+				Rotate(parent, grandParent, parentIsLeft);
+				parent = node;
+			}
+			Rotate(grandParent, greatGrandParent, !parentIsLeft);
+
+			SetColor(parent, Node::Color::Black);
+			SetColor(grandParent, Node::Color::Red);
+			break;
+		}
+
+		SetColor(Root(), Node::Color::Black);
+	}
+
+	inline void RemoveFixup(Node* node) {
+		while (!m_Path.empty() && NodeIsBlack(node)) {
+			Node* parent = m_Path.back();
+			Node* grandParent = m_Path.size() >= 2 ? m_Path[m_Path.size() - 2] : nullptr;
+
+			bool nodeIsLeft = node ? node->Data < parent->Data : !parent->Left();
+			Node* sibling = parent->Child(!nodeIsLeft);
+			if (sibling->IsRed()) {
+				SetColor(sibling, Node::Color::Black);
+				SetColor(parent, Node::Color::Red);
+				Rotate(parent, grandParent, nodeIsLeft);
+
+				m_Path.insert(m_Path.end() - 1, sibling);
+				grandParent = sibling;
+				sibling = parent->Child(!nodeIsLeft);
+			}
+
+			if (NodeIsBlack(sibling->Left()) && NodeIsBlack(sibling->Right())) {
+				SetColor(sibling, Node::Color::Red);
+				node = parent;
+				m_Path.pop_back();
+				continue;
+			}
+
+			if (NodeIsBlack(sibling->Child(!nodeIsLeft))) {
+				SetColor(sibling->Child(nodeIsLeft), Node::Color::Black);
+				SetColor(sibling, Node::Color::Red);
+				sibling = Rotate(sibling, parent, !nodeIsLeft);
+			}
+
+			SetColor(sibling, parent->GetColor());
+			SetColor(parent, Node::Color::Black);
+			SetColor(sibling->Child(!nodeIsLeft), Node::Color::Black);
+			Rotate(parent, grandParent, nodeIsLeft);
+
+			node = Root();
+			break;
+		}
+
+		if (node)
+			SetColor(node, Node::Color::Black);
+	}
+
+	// Rotates the subtree rooted at node, whose parent is parent, and returns
+	// the node that took its place.
+	inline Node* Rotate(Node* node, Node* parent, bool left) {
+		Node* child = node->Child(!left);
+
+		SetChild(node, !left, child->Child(left));
+		SetChild(child, left, node);
+		ReplaceChild(parent, node->Data, child);
+
+		return child;
+	}
+
+	inline void ReplaceChild(Node* parent, int oldChildKey, Node* newChild) {
+		if (!parent)
+			SetRoot(newChild, m_CurrentVersion);
+		else
+			SetChild(parent, oldChildKey < parent->Data, newChild);
+	}
+
+	inline void SetChild(Node* node, bool left, Node* child) {
+		if (node->Child(left) != child && node->SetChild(left, child, m_CurrentVersion))
+			m_Copied.push_back(node->Data);
+	}
+
+	inline void SetColor(Node* node, Node::Color color) {
+		if (node->GetColor() != color && node->SetColor(color, m_CurrentVersion))
+			m_Copied.push_back(node->Data);
+	}
+
+	// Points the parents of the nodes copied during this version to the
+	// copies. Relinking may copy the parents, which are then relinked too.
+	inline void RelinkCopies() {
+		for (std::size_t i = 0; i < m_Copied.size(); i++) {
+			int key = m_Copied[i];
+
+			Node* parent = nullptr;
+			Node* current = Root();
+			while (current && current->Data != key) {
+				parent = current;
+				current = current->Child(key < current->Data);
+			}
+			if (!current || current->Latest() == current)
+				continue;
+
+			ReplaceChild(parent, key, current->Latest());
+		}
+
+		m_Copied.clear();
+	}
+
+	inline bool NodeIsBlack(Node* node, int version = INT32_MAX) const {
+		return !node || node->IsBlack(version);
+	}
+
+	inline void PrintHelper(Node* node, int ident, int version, bool isLeftChild) const {
+		if (!node)
+			return;
+
+		std::cout << std::string(ident, ' ')
+			<< node->Data
+			<< (isLeftChild ? "L" : "R")
+			<< (node->IsBlack(version) ? " (B)" : " (R)") << std::endl;
+		PrintHelper(node->Right(version), ident + 8, version, false);
+		PrintHelper(node->Left(version), ident + 8, version, true);
+	}
+	inline void FPrintHelper(Node* node, int version, int depth, std::ostream& outFileStream) const {
+		if (!node)
+			return;
+		FPrintHelper(node->Left(version), version, depth + 1, outFileStream);
+		outFileStream << node->Data << ',' << depth << ',' << (node->IsBlack(version) ? "N" : "R") << ' ';
+		FPrintHelper(node->Right(version), version, depth + 1, outFileStream);
+	}
+
+	struct VersionedRoot {
+		Node* Root;
+		int Version;
+
+		inline VersionedRoot(Node* root, int version) : Root(root), Version(version) {}
+	};
+	inline void SetRoot(Node* root, int version) {
+		if (m_Roots.back().Version == version)
+			m_Roots.back().Root = root;
+		else
+			m_Roots.emplace_back(root, version);
+	}
+
+	inline Node* Root(int version = INT32_MAX) const {
+		for (auto versionedRoot = m_Roots.rbegin(); versionedRoot != m_Roots.rend(); versionedRoot++) {
+			if (versionedRoot->Version <= version)
+				return versionedRoot->Root;
+		}
+
+		return nullptr;
+	}
+
+private:
+	int m_CurrentVersion{ 0 };
+	std::vector<VersionedRoot> m_Roots;
+
+	std::vector<Node*> m_Path;
+	std::vector<int> m_Copied;
+};
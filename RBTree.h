@@ -1,5 +1,14 @@
 #pragma once
 
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <iostream>
 
@@ -10,6 +19,10 @@ public:
 		m_Roots.emplace_back(nullptr, 0);
 	}
 
+	// Compact frees the nodes it relocates, so copies would share them.
+	RBTree(const RBTree&) = delete;
+	RBTree& operator=(const RBTree&) = delete;
+
 	class Node {
 	public:
 		enum class Color { Black, Red };
@@ -20,12 +33,14 @@ public:
 				Color TheColor;
 				Node* Pointer;
 
+				inline Field() : Pointer(nullptr) {}
 				inline Field(Node* pointer) : Pointer(pointer) {}
 				inline Field(Color color) : TheColor(color) {}
 			};
 
 			enum class Type { Left, Right, Parent, Color };
 
+			Modification() = default;
 			Modification(Type fieldType, Field field, int version) : FieldType(fieldType), TheField(field), Version(version) {}
 
 		public:
@@ -34,13 +49,13 @@ public:
 			Field TheField;
 		};
 
-		inline Node(int data, Color color) : Data(data), m_Color(color) { m_Mods.reserve(ModificationsLimit); }
+		inline Node(int data, Color color) : Data(data), m_Color(color) {}
 		inline Node(int data, Color color, Node* left, Node* right, Node* parent, Node* returnLeft, Node* returnRight, Node* returnParent)
 			: Data(data), m_Color(color), m_Left(left), m_Right(right), m_Parent(parent), m_ReturnLeft(returnLeft),
 			m_ReturnRight(returnRight), m_ReturnParent(returnParent)
 		{
-			m_Mods.reserve(ModificationsLimit);
 		}
+		inline virtual ~Node() = default;
 		static constexpr int ModificationsLimit = 6;
 
 		inline virtual bool IsNil() const { return false; }
@@ -108,14 +123,35 @@ public:
 			return parent->Left(version);
 		}
 
+		// The copy that holds the fields of this node at version, if any.
+		inline Node* NextCopy(int version = INT32_MAX) const {
+			return m_Next && LatestVersion() <= version ? m_Next : nullptr;
+		}
+
+		template <typename Visitor>
+		inline void VisitPointers(Visitor visit) {
+			visit(m_Left);
+			visit(m_Right);
+			visit(m_Parent);
+			visit(m_ReturnLeft);
+			visit(m_ReturnRight);
+			visit(m_ReturnParent);
+			visit(m_Next);
+
+			for (int i = 0; i < m_ModsCount; i++) {
+				if (m_Mods[i].FieldType != Modification::Type::Color)
+					visit(m_Mods[i].TheField.Pointer);
+			}
+		}
+
 	private:
 		inline Modification::Field GetField(Modification::Type fieldType, int version) const {
 			if (m_Next && LatestVersion() <= version)
 				return m_Next->GetField(fieldType, version);
 
-			for (auto mod = m_Mods.rbegin(); mod != m_Mods.rend(); mod++) {
-				if (mod->Version <= version && mod->FieldType == fieldType)
-					return mod->TheField;
+			for (int i = m_ModsCount - 1; i >= 0; i--) {
+				if (m_Mods[i].Version <= version && m_Mods[i].FieldType == fieldType)
+					return m_Mods[i].TheField;
 			}
 
 			switch (fieldType)
@@ -139,11 +175,21 @@ public:
 				return;
 			}
 
-			m_Mods.emplace_back(fieldType, field, version);
+			// Bulk operations touch the same field several times in one version,
+			// only the last value is visible so it replaces the previous one.
+			for (int i = m_ModsCount - 1; i >= 0 && m_Mods[i].Version == version; i--) {
+				if (m_Mods[i].FieldType == fieldType) {
+					m_Mods[i].TheField = field;
+					SwicthReturnPointers(fieldType, this, field.Pointer);
+					return;
+				}
+			}
+
+			m_Mods[m_ModsCount++] = Modification(fieldType, field, version);
 
 			SwicthReturnPointers(fieldType, this, field.Pointer);
 
-			if (m_Mods.size() == ModificationsLimit)
+			if (m_ModsCount == ModificationsLimit)
 				CreateNewNode(version);
 		}
 
@@ -193,7 +239,7 @@ public:
 			}
 		}
 
-		inline int LatestVersion() const { return m_Mods.back().Version; }
+		inline int LatestVersion() const { return m_Mods[m_ModsCount - 1].Version; }
 
 	public:
 		int Data;
@@ -205,7 +251,9 @@ public:
 
 		Color m_Color;
 
-		std::vector<Modification> m_Mods;
+		// Kept inline so a node and its modification log share its storage.
+		Modification m_Mods[ModificationsLimit];
+		int m_ModsCount{ 0 };
 
 		Node* m_ReturnLeft{ nullptr };
 		Node* m_ReturnRight{ nullptr };
@@ -220,6 +268,18 @@ public:
 
 		inline bool IsNil() const override { return true; }
 	};
+	static_assert(sizeof(Nil) == sizeof(Node), "Compact stores Nil and Node in the same slots");
+
+	struct CompactionReport {
+		std::size_t Nodes;
+		std::size_t BytesBefore;
+		std::size_t BytesAfter;
+		std::size_t BytesSaved;
+		double CacheLinesPerSearchBefore;
+		double CacheLinesPerSearchAfter;
+		double PagesPerSearchBefore;
+		double PagesPerSearchAfter;
+	};
 
 	inline Node* Search(int data, int version = INT32_MAX) const {
 		Node* current = Root(version);
@@ -326,10 +386,305 @@ public:
 			SwapParentsChild(movedUpNode->Parent(), movedUpNode, nullptr);
 	}
 
+	// Moves every node of every version into one contiguous block, first the
+	// nodes of the given version in page sized subtrees and then the rest,
+	// remapping all pointers. Nodes are packed back to back, so a search
+	// reads few pages. Bytes before count
+	// one malloc chunk per heap node. Cache lines and pages are counted over
+	// searches for the keys of that version. Every Node* previously returned
+	// by Search is invalidated.
+	inline CompactionReport Compact(int version = INT32_MAX) {
+		CompactionReport report{};
+		report.CacheLinesPerSearchBefore = BlocksPerSearch(version, CacheLineSize);
+		report.PagesPerSearchBefore = BlocksPerSearch(version, PageSize);
+
+		std::vector<Node*> order = CompactionOrder(version);
+		char* arena = static_cast<char*>(::operator new(order.size() * sizeof(Node), std::align_val_t(CacheLineSize)));
+
+		std::unordered_map<Node*, Node*> relocated;
+		relocated.reserve(order.size());
+		for (std::size_t i = 0; i < order.size(); i++) {
+			relocated.emplace(order[i], reinterpret_cast<Node*>(arena + i * sizeof(Node)));
+			if (!InArena(order[i]))
+				report.BytesBefore += MallocChunkSize(sizeof(Node));
+		}
+		report.BytesBefore += m_ArenaSize;
+
+		auto remap = [&relocated](Node*& pointer) {
+			if (pointer)
+				pointer = relocated.at(pointer);
+		};
+		for (std::size_t i = 0; i < order.size(); i++) {
+			Node* node = order[i];
+			void* slot = arena + i * sizeof(Node);
+			Node* copy = node->IsNil() ? new (slot) Nil(*static_cast<Nil*>(node)) : new (slot) Node(*node);
+			copy->VisitPointers(remap);
+		}
+		for (VersionedRoot& versionedRoot : m_Roots)
+			remap(versionedRoot.Root);
+
+		for (Node* node : order) {
+			if (!InArena(node))
+				delete node;
+		}
+		if (m_Arena)
+			::operator delete(m_Arena, std::align_val_t(CacheLineSize));
+
+		m_Arena = arena;
+		m_ArenaSize = order.size() * sizeof(Node);
+
+		report.Nodes = order.size();
+		report.BytesAfter = m_ArenaSize;
+		report.BytesSaved = report.BytesBefore > report.BytesAfter ? report.BytesBefore - report.BytesAfter : 0;
+		report.CacheLinesPerSearchAfter = BlocksPerSearch(version, CacheLineSize);
+		report.PagesPerSearchAfter = BlocksPerSearch(version, PageSize);
+
+		return report;
+	}
+
+	inline std::vector<int> Keys(int version = INT32_MAX) const {
+		std::vector<int> keys;
+		KeysHelper(Root(version), version, keys);
+
+		return keys;
+	}
+
+	// Keys in [lo, hi] at version, in increasing order.
+	inline std::vector<int> KeysInRange(int lo, int hi, int version = INT32_MAX) const {
+		std::vector<int> keys;
+		KeysInRangeHelper(Root(version), lo, hi, version, keys);
+
+		return keys;
+	}
+
+	inline void InsertBatch(std::vector<int> keys, bool parallel = true) {
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		Union(keys, parallel);
+	}
+
+	// Removes every key in [lo, hi] in a single version.
+	inline void RemoveRange(int lo, int hi) {
+		if (lo > hi)
+			return;
+
+		m_CurrentVersion++;
+
+		SplitResult lower = Split(Root(), lo);
+		SplitResult upper = Split(lower.Right, hi);
+
+		SetBulkRoot(Join(lower.Left, upper.Right));
+	}
+
+	// sortedKeys must be sorted and without duplicates.
+	inline void Union(const std::vector<int>& sortedKeys, bool parallel = true) {
+		m_CurrentVersion++;
+
+		WorkStealingPool* pool = parallel && sortedKeys.size() >= ParallelCutoff ? Pool() : nullptr;
+		SetBulkRoot(UnionHelper(Root(), sortedKeys, 0, static_cast<int>(sortedKeys.size()), pool));
+	}
+	inline void Union(const RBTree& other, int version = INT32_MAX) { Union(other.Keys(version)); }
+
+	// sortedKeys must be sorted and without duplicates.
+	inline void Difference(const std::vector<int>& sortedKeys, bool parallel = true) {
+		m_CurrentVersion++;
+
+		WorkStealingPool* pool = parallel && sortedKeys.size() >= ParallelCutoff ? Pool() : nullptr;
+		SetBulkRoot(DifferenceHelper(Root(), sortedKeys, 0, static_cast<int>(sortedKeys.size()), pool));
+	}
+	inline void Difference(const RBTree& other, int version = INT32_MAX) { Difference(other.Keys(version)); }
+
 private:
-	inline void SwapParentsChild(Node* parent, Node* oldChild, Node* newChild) {
-		if (!parent)
-			SetRoot(newChild, m_CurrentVersion);
+	struct SplitResult {
+		Node* Left;
+		Node* Found;
+		Node* Right;
+	};
+
+	// Splits the detached subtree rooted at node into the keys smaller and
+	// greater than key. All the pieces are detached red-black trees.
+	inline SplitResult Split(Node* node, int key) {
+		if (!node)
+			return { nullptr, nullptr, nullptr };
+
+		Node* left = node->Left();
+		Node* right = node->Right();
+		LinkChildren(node, nullptr, nullptr);
+		Unlink(left);
+		Unlink(right);
+
+		if (key == node->Data)
+			return { left, node, right };
+
+		if (key < node->Data) {
+			SplitResult result = Split(left, key);
+			return { result.Left, result.Found, Join(result.Right, node, right) };
+		}
+
+		SplitResult result = Split(right, key);
+		return { Join(left, node, result.Left), result.Found, result.Right };
+	}
+
+	// Joins the detached trees left and right, whose keys are smaller and
+	// greater than middle->Data, hanging middle on the spine of the taller
+	// tree at the black height of the shorter one.
+	inline Node* Join(Node* left, Node* middle, Node* right) {
+		MakeBlack(left);
+		MakeBlack(right);
+
+		int leftHeight = BlackHeight(left);
+		int rightHeight = BlackHeight(right);
+		if (leftHeight == rightHeight) {
+			LinkChildren(middle, left, right);
+			MakeBlack(middle);
+			return middle;
+		}
+
+		bool descendRight = leftHeight > rightHeight;
+		int height = std::max(leftHeight, rightHeight);
+		int targetHeight = std::min(leftHeight, rightHeight);
+
+		Node* parent = nullptr;
+		Node* current = descendRight ? left : right;
+		while (!NodeIsBlack(current) || height > targetHeight) {
+			if (current->IsBlack())
+				height--;
+
+			parent = current;
+			current = descendRight ? current->Right() : current->Left();
+		}
+
+		if (descendRight) {
+			parent->SetRight(middle, m_CurrentVersion);
+			middle->SetParent(parent, m_CurrentVersion);
+			LinkChildren(middle, current, right);
+		} else {
+			parent->SetLeft(middle, m_CurrentVersion);
+			middle->SetParent(parent, m_CurrentVersion);
+			LinkChildren(middle, left, current);
+		}
+
+		if (middle->IsBlack())
+			middle->SetRed(m_CurrentVersion);
+		InsertFixup(middle, true);
+
+		Node* root = middle;
+		while (root->Parent())
+			root = root->Parent();
+
+		return root;
+	}
+
+	inline Node* Join(Node* left, Node* right) {
+		if (!left)
+			return right;
+		if (!right)
+			return left;
+
+		SplitResult result = Split(left, Maximun(left)->Data);
+		return Join(result.Left, result.Found, right);
+	}
+
+	// The pieces returned by Split share no nodes, so both halves of a key
+	// range large enough to pay for a task are processed in parallel.
+	static constexpr std::size_t ParallelCutoff = 2048;
+
+	// Started on the first parallel bulk operation and kept for the next ones.
+	inline WorkStealingPool* Pool() {
+		if (!m_Pool)
+			m_Pool.reset(new WorkStealingPool());
+
+		return m_Pool.get();
+	}
+
+	inline Node* UnionHelper(Node* node, const std::vector<int>& sortedKeys, int lo, int hi, WorkStealingPool* pool) {
+		if (lo >= hi)
+			return node;
+
+		int mid = lo + (hi - lo) / 2;
+		SplitResult result = Split(node, sortedKeys[mid]);
+		Node* middle = result.Found ? result.Found : new Node(sortedKeys[mid], Node::Color::Red);
+
+		Node* left;
+		Node* right;
+		if (pool && static_cast<std::size_t>(hi - lo) >= ParallelCutoff) {
+			pool->Invoke([&] { left = UnionHelper(result.Left, sortedKeys, lo, mid, pool); },
+				[&] { right = UnionHelper(result.Right, sortedKeys, mid + 1, hi, pool); });
+		} else {
+			left = UnionHelper(result.Left, sortedKeys, lo, mid, pool);
+			right = UnionHelper(result.Right, sortedKeys, mid + 1, hi, pool);
+		}
+
+		return Join(left, middle, right);
+	}
+
+	inline Node* DifferenceHelper(Node* node, const std::vector<int>& sortedKeys, int lo, int hi, WorkStealingPool* pool) {
+		if (!node || lo >= hi)
+			return node;
+
+		int mid = lo + (hi - lo) / 2;
+		SplitResult result = Split(node, sortedKeys[mid]);
+
+		Node* left;
+		Node* right;
+		if (pool && static_cast<std::size_t>(hi - lo) >= ParallelCutoff) {
+			pool->Invoke([&] { left = DifferenceHelper(result.Left, sortedKeys, lo, mid, pool); },
+				[&] { right = DifferenceHelper(result.Right, sortedKeys, mid + 1, hi, pool); });
+		} else {
+			left = DifferenceHelper(result.Left, sortedKeys, lo, mid, pool);
+			right = DifferenceHelper(result.Right, sortedKeys, mid + 1, hi, pool);
+		}
+
+		return Join(left, right);
+	}
+
+	inline void LinkChildren(Node* node, Node* left, Node* right) {
+		if (node->Left() != left) {
+			node->SetLeft(left, m_CurrentVersion);
+			if (left)
+				left->SetParent(node, m_CurrentVersion);
+		}
+
+		if (node->Right() != right) {
+			node->SetRight(right, m_CurrentVersion);
+			if (right)
+				right->SetParent(node, m_CurrentVersion);
+		}
+	}
+
+	inline void Unlink(Node* node) {
+		if (node && node->Parent())
+			node->SetParent(nullptr, m_CurrentVersion);
+	}
+
+	inline void MakeBlack(Node* node) {
+		if (node && node->IsRed())
+			node->SetBlack(m_CurrentVersion);
+	}
+
+	inline int BlackHeight(Node* node) const {
+		int height = 0;
+		for (; node; node = node->Left()) {
+			if (node->IsBlack())
+				height++;
+		}
+
+		return height;
+	}
+
+	inline void SetBulkRoot(Node* root) {
+		MakeBlack(root);
+		SetRoot(root, m_CurrentVersion);
+	}
+
+	// A detached subtree is a piece of a bulk operation, so replacing its top
+	// does not touch the versioned roots.
+	inline void SwapParentsChild(Node* parent, Node* oldChild, Node* newChild, bool detached = false) {
+		if (!parent) {
+			if (!detached)
+				SetRoot(newChild, m_CurrentVersion);
+		}
 		else if (oldChild->IsLeftChildOf(parent))
 			parent->SetLeft(newChild, m_CurrentVersion);
 		else if (oldChild->IsRightChildOf(parent))
@@ -341,7 +696,7 @@ private:
 			newChild->SetParent(parent, m_CurrentVersion);
 	}
 
-	inline void RotateRight(Node* node) {
+	inline Node* RotateRight(Node* node, bool detached = false) {
 		Node* parent = node->Parent();
 		Node* left = node->Left();
 		Node* leftRight = left->Right();
@@ -353,10 +708,11 @@ private:
 		left->SetRight(node, m_CurrentVersion);
 		node->SetParent(left, m_CurrentVersion);
 
-		SwapParentsChild(parent, node, left);
+		SwapParentsChild(parent, node, left, detached);
+		return left;
 	}
 
-	inline void RotateLeft(Node* node) {
+	inline Node* RotateLeft(Node* node, bool detached = false) {
 		Node* parent = node->Parent();
 		Node* right = node->Right();
 		Node* rightLeft = right->Left();
@@ -368,10 +724,11 @@ private:
 		right->SetLeft(node, m_CurrentVersion);
 		node->SetParent(right, m_CurrentVersion);
 
-		SwapParentsChild(parent, node, right);
+		SwapParentsChild(parent, node, right, detached);
+		return right;
 	}
 
-	inline void InsertFixup(Node* node) {
+	inline void InsertFixup(Node* node, bool detached = false) {
 		Node* parent = node->Parent();
 
 		if (!parent) {
@@ -394,24 +751,24 @@ private:
 			grandParent->SetRed(m_CurrentVersion);
 			uncle->SetBlack(m_CurrentVersion);
 
-			InsertFixup(grandParent);
+			InsertFixup(grandParent, detached);
 		} else if (parent->IsLeftChildOf(grandParent)) {
 			if (node->IsRightChildOf(parent)) {
-				RotateLeft(parent);
+				RotateLeft(parent, detached);
 				parent = node;
 			}
 
-			RotateRight(grandParent);
+			RotateRight(grandParent, detached);
 
 			parent->SetBlack(m_CurrentVersion);
 			grandParent->SetRed(m_CurrentVersion);
 		} else {
 			if (node->IsLeftChildOf(parent)) {
-				RotateRight(parent);
+				RotateRight(parent, detached);
 				parent = node;
 			}
 
-			RotateLeft(grandParent);
+			RotateLeft(grandParent, detached);
 
 			parent->SetBlack(m_CurrentVersion);
 			grandParent->SetRed(m_CurrentVersion);
@@ -499,6 +856,13 @@ private:
 		return node;
 	}
 
+	inline Node* Maximun(Node* node, int version = INT32_MAX) const {
+		while (node->Right(version))
+			node = node->Right(version);
+
+		return node;
+	}
+
 	inline bool NodeIsBlack(Node* node, int version = INT32_MAX) const {
 		return !node || node->IsBlack(version);
 	}
@@ -514,6 +878,112 @@ private:
 		PrintHelper(node->Right(version), ident + 8, version, false);
 		PrintHelper(node->Left(version), ident + 8, version, true);
 	}
+	inline std::vector<Node*> CompactionOrder(int version) const {
+		std::unordered_set<Node*> visited;
+		std::vector<Node*> order;
+		auto visit = [&visited, &order](Node*& node) {
+			if (node && visited.insert(node).second)
+				order.push_back(node);
+		};
+
+		// Each block is a breadth-first prefix of a subtree that fills about a
+		// page; the subtrees hanging below it become the next blocks, depth first.
+		std::vector<Node*> blocks{ Root(version) };
+		std::vector<Node*> queue;
+		while (!blocks.empty()) {
+			queue.assign(1, blocks.back());
+			blocks.pop_back();
+
+			std::size_t blockStart = order.size();
+			std::size_t frontier = blocks.size();
+			for (std::size_t i = 0; i < queue.size(); i++) {
+				Node* node = queue[i];
+				if (!node || visited.count(node))
+					continue;
+				if ((order.size() - blockStart + 1) * sizeof(Node) > PageSize) {
+					blocks.push_back(node);
+					continue;
+				}
+
+				for (Node* copy = node; copy; copy = copy->NextCopy(version))
+					visit(copy);
+
+				queue.push_back(node->Left(version));
+				queue.push_back(node->Right(version));
+			}
+			std::reverse(blocks.begin() + frontier, blocks.end());
+		}
+
+		for (VersionedRoot versionedRoot : m_Roots)
+			visit(versionedRoot.Root);
+		for (std::size_t i = 0; i < order.size(); i++)
+			order[i]->VisitPointers(visit);
+
+		return order;
+	}
+
+	// Distinct blocks of blockSize bytes read per search, over a sample of the
+	// keys of version.
+	inline double BlocksPerSearch(int version, std::size_t blockSize) const {
+		std::vector<int> keys = Keys(version);
+		if (keys.empty())
+			return 0.0;
+
+		std::size_t step = std::max<std::size_t>(1, keys.size() / 1024);
+		std::size_t searches = 0;
+		std::size_t blocks = 0;
+		std::unordered_set<std::uintptr_t> touched;
+		for (std::size_t i = 0; i < keys.size(); i += step) {
+			touched.clear();
+
+			Node* current = Root(version);
+			while (current) {
+				for (Node* copy = current; copy; copy = copy->NextCopy(version)) {
+					std::uintptr_t address = reinterpret_cast<std::uintptr_t>(copy);
+					for (std::uintptr_t block = address / blockSize; block <= (address + sizeof(Node) - 1) / blockSize; block++)
+						touched.insert(block);
+				}
+
+				if (current->Data == keys[i])
+					break;
+				current = keys[i] < current->Data ? current->Left(version) : current->Right(version);
+			}
+
+			blocks += touched.size();
+			searches++;
+		}
+
+		return static_cast<double>(blocks) / searches;
+	}
+
+	inline bool InArena(Node* node) const {
+		char* address = reinterpret_cast<char*>(node);
+		return m_Arena && !std::less<char*>()(address, m_Arena) && std::less<char*>()(address, m_Arena + m_ArenaSize);
+	}
+
+	// Chunk taken by a glibc malloc of size bytes: the size word plus the
+	// request, rounded up to 16 bytes, at least 32.
+	static inline std::size_t MallocChunkSize(std::size_t size) {
+		return std::max<std::size_t>(32, (size + sizeof(std::size_t) + 15) & ~static_cast<std::size_t>(15));
+	}
+
+	inline void KeysInRangeHelper(Node* node, int lo, int hi, int version, std::vector<int>& keys) const {
+		if (!node)
+			return;
+		if (lo < node->Data)
+			KeysInRangeHelper(node->Left(version), lo, hi, version, keys);
+		if (lo <= node->Data && node->Data <= hi)
+			keys.push_back(node->Data);
+		if (node->Data < hi)
+			KeysInRangeHelper(node->Right(version), lo, hi, version, keys);
+	}
+	inline void KeysHelper(Node* node, int version, std::vector<int>& keys) const {
+		if (!node)
+			return;
+		KeysHelper(node->Left(version), version, keys);
+		keys.push_back(node->Data);
+		KeysHelper(node->Right(version), version, keys);
+	}
 	inline void FPrintHelper(Node* node, int version, int depth, std::ostream& outFileStream) const {
 		if (!node)
 			return;
@@ -529,7 +999,10 @@ private:
 		inline VersionedRoot(Node* root, int version) : Root(root), Version(version) {}
 	};
 	inline void SetRoot(Node* root, int version) {
-		m_Roots.emplace_back(root, version);
+		if (m_Roots.back().Version == version)
+			m_Roots.back().Root = root;
+		else
+			m_Roots.emplace_back(root, version);
 	}
 
 	inline Node* Root(int version = INT32_MAX) const {
@@ -544,4 +1017,12 @@ private:
 private:
 	int m_CurrentVersion{ 0 };
 	std::vector<VersionedRoot> m_Roots;
+
+	static constexpr std::size_t CacheLineSize = 64;
+	static constexpr std::size_t PageSize = 4096;
+
+	char* m_Arena{ nullptr };
+	std::size_t m_ArenaSize{ 0 };
+
+	std::unique_ptr<WorkStealingPool> m_Pool;
 };
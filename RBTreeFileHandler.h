@@ -0,0 +1,133 @@
+#pragma once
+
+#include "RBTree.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+template <typename TreeType = RBTree>
+class RBTreeFileHandler
+{
+public:
+	inline RBTreeFileHandler(std::string inputFilePath, std::string outputFilePath)
+	{
+		m_FileReader.open(inputFilePath, std::ios::in);
+		if (m_FileReader.fail())
+		{
+			std::cerr<< "Error: Couldnt open input file " << inputFilePath << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		m_FileWriter.open(outputFilePath, std::ios::out);
+		if (m_FileWriter.fail())
+		{
+			std::cerr << "Error: Couldnt open output file " << outputFilePath << std::endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	inline ~RBTreeFileHandler()
+	{
+		m_FileReader.close();
+		m_FileWriter.close();
+	}
+
+	void ExecComands()
+	{
+		std::vector<std::string> tokens;
+		while (NextComand(tokens))
+		{
+			if (!ExecComand(tokens))
+				return;
+		}
+	}
+
+	inline bool NextComand(std::vector<std::string>& tokens)
+	{
+		std::string line;
+		if (!std::getline(m_FileReader, line))
+			return false;
+
+		tokens = SplitOnSpace(line);
+		return tokens.size() != 0;
+	}
+
+	bool ExecComand(const std::vector<std::string>& tokens)
+	{
+		if (tokens.front() == "INC")
+		{
+			if (tokens.size() != 2)
+			{
+				std::cerr << "Error: INC command requires 2 argument" << std::endl;
+				return false;
+			}
+
+			int key = std::stoi(tokens[1]);
+			m_Tree.Insert(key);
+		}
+		else if (tokens.front() == "REM")
+		{
+			if (tokens.size() != 2)
+			{
+				std::cerr << "Error: REM command requires 2 argument" << std::endl;
+				return false;
+			}
+
+			int key = std::stoi(tokens[1]);
+			m_Tree.Remove(key);
+		}
+		else if (tokens.front() == "SUC")
+		{
+			if (tokens.size() != 3)
+			{
+				std::cerr << "Error: SUC command requires 2 arguments" << std::endl;
+				return false;
+			}
+
+			int key = std::stoi(tokens[1]);
+			int version = std::stoi(tokens[2]);
+			int successor = m_Tree.Successor(key, version);
+                m_FileWriter << "SUC " << key << " " << version << '\n';
+			m_FileWriter << (successor == INT32_MAX ? "Infinito" : std::to_string(successor)) << '\n';
+		}
+		else if (tokens.front() == "IMP")
+		{
+			if (tokens.size() != 2)
+			{
+				std::cerr << "Error: IMP command requires 1 argument" << std::endl;
+				return false;
+			}
+
+			int version = std::stoi(tokens[1]);
+                m_FileWriter << "IMP " << version << '\n';
+			m_Tree.FPrint(version, m_FileWriter);
+		}
+		else
+		{
+			std::cerr << "Error: Unknown command " << tokens.front() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	inline const TreeType& Tree() const { return m_Tree; }
+
+private:
+	inline std::vector<std::string> SplitOnSpace(std::string line) const
+	{
+		std::stringstream ss(line);
+		std::string token;
+		std::vector<std::string> tokens;
+		while (ss >> token)
+			tokens.push_back(token);
+
+		return tokens;
+	}
+
+private:
+	std::ifstream m_FileReader;
+	std::ofstream m_FileWriter;
+
+	TreeType m_Tree;
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "RBTree.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Partitions [minKey, maxKey] in contiguous key ranges across independent
+// RBTree shards, each one updated by its own thread. Writes are queued to the
+// shards and Commit waits for them to be applied, recording the version of
+// every shard as a new epoch. Queries take an epoch, so a Successor or Range
+// crossing shards sees all of them at the same point in time. Insert, Remove
+// and Commit are meant to be called from a single thread; queries wait for
+// the pending writes before reading the shards.
+class ShardedRBTree {
+public:
+	inline ShardedRBTree(int shardCount, int minKey = 0, int maxKey = INT32_MAX)
+		: m_MinKey(minKey), m_MaxKey(maxKey)
+	{
+		if (shardCount <= 0 || minKey > maxKey)
+			throw std::runtime_error("Invalid shard count or key range, ShardedRBTree");
+
+		for (int i = 0; i < shardCount; i++)
+			m_Shards.emplace_back(new Shard());
+		for (auto& shard : m_Shards)
+			shard->Worker = std::thread(&ShardedRBTree::Work, this, std::ref(*shard));
+
+		m_Epochs.emplace_back(shardCount, 0);
+	}
+
+	inline ~ShardedRBTree() {
+		for (auto& shard : m_Shards) {
+			{
+				std::lock_guard<std::mutex> lock(shard->Mutex);
+				shard->Stopping = true;
+			}
+			shard->Condition.notify_all();
+		}
+
+		for (auto& shard : m_Shards)
+			shard->Worker.join();
+	}
+
+	inline void Insert(int key) { Enqueue(ShardIndex(key), { key, true }); }
+	inline void Remove(int key) { Enqueue(ShardIndex(key), { key, false }); }
+
+	inline void InsertBatch(const std::vector<int>& keys) {
+		std::vector<std::vector<Operation>> operations(m_Shards.size());
+		for (int key : keys)
+			operations[ShardIndex(key)].push_back({ key, true });
+
+		for (std::size_t i = 0; i < m_Shards.size(); i++) {
+			if (operations[i].empty())
+				continue;
+
+			Shard& shard = *m_Shards[i];
+			{
+				std::lock_guard<std::mutex> lock(shard.Mutex);
+				shard.Pending.insert(shard.Pending.end(), operations[i].begin(), operations[i].end());
+			}
+			shard.Condition.notify_all();
+		}
+	}
+
+	// Waits for the queued writes and returns the epoch that contains them.
+	inline int Commit() {
+		Wait();
+
+		std::vector<int> versions;
+		versions.reserve(m_Shards.size());
+		for (auto& shard : m_Shards)
+			versions.push_back(shard->Tree.CurrentVersion());
+
+		m_Epochs.push_back(versions);
+		return CurrentEpoch();
+	}
+
+	inline int CurrentEpoch() const { return static_cast<int>(m_Epochs.size()) - 1; }
+	inline int ShardCount() const { return static_cast<int>(m_Shards.size()); }
+
+	inline bool Contains(int key, int epoch = INT32_MAX) {
+		Wait();
+
+		int shard = ShardIndex(key);
+		return m_Shards[shard]->Tree.Search(key, ShardVersion(shard, epoch)) != nullptr;
+	}
+
+	inline int Successor(int data, int epoch = INT32_MAX) {
+		Wait();
+
+		for (int shard = ShardIndex(data); shard < ShardCount(); shard++) {
+			int successor = m_Shards[shard]->Tree.Successor(data, ShardVersion(shard, epoch));
+			if (successor != INT32_MAX)
+				return successor;
+		}
+
+		return INT32_MAX;
+	}
+
+	// Keys in [lo, hi] at the given epoch, in increasing order.
+	inline std::vector<int> Range(int lo, int hi, int epoch = INT32_MAX) {
+		std::vector<int> keys;
+		if (lo > hi)
+			return keys;
+
+		Wait();
+
+		for (int shard = ShardIndex(lo); shard <= ShardIndex(hi); shard++) {
+			std::vector<int> shardKeys = m_Shards[shard]->Tree.KeysInRange(lo, hi, ShardVersion(shard, epoch));
+			keys.insert(keys.end(), shardKeys.begin(), shardKeys.end());
+		}
+
+		return keys;
+	}
+
+private:
+	struct Operation {
+		int Key;
+		bool IsInsert;
+	};
+
+	struct Shard {
+		RBTree Tree;
+
+		std::mutex Mutex;
+		std::condition_variable Condition;
+		std::vector<Operation> Pending;
+		bool Busy{ false };
+		bool Stopping{ false };
+
+		std::thread Worker;
+	};
+
+	inline void Work(Shard& shard) {
+		std::vector<Operation> operations;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(shard.Mutex);
+				shard.Busy = false;
+				shard.Condition.notify_all();
+				shard.Condition.wait(lock, [&shard] { return shard.Stopping || !shard.Pending.empty(); });
+				if (shard.Pending.empty())
+					return;
+
+				operations.swap(shard.Pending);
+				shard.Busy = true;
+			}
+
+			// Each run of consecutive inserts becomes a single version. The
+			// shards already run in parallel, so the batches do not fork.
+			std::vector<int> inserts;
+			for (const Operation& operation : operations) {
+				if (operation.IsInsert) {
+					inserts.push_back(operation.Key);
+					continue;
+				}
+
+				if (!inserts.empty()) {
+					shard.Tree.InsertBatch(inserts, false);
+					inserts.clear();
+				}
+				shard.Tree.Remove(operation.Key);
+			}
+			if (!inserts.empty())
+				shard.Tree.InsertBatch(inserts, false);
+			operations.clear();
+		}
+	}
+
+	inline void Enqueue(int shardIndex, Operation operation) {
+		Shard& shard = *m_Shards[shardIndex];
+		{
+			std::lock_guard<std::mutex> lock(shard.Mutex);
+			shard.Pending.push_back(operation);
+		}
+		shard.Condition.notify_all();
+	}
+
+	inline void Wait() {
+		for (auto& shard : m_Shards) {
+			std::unique_lock<std::mutex> lock(shard->Mutex);
+			shard->Condition.wait(lock, [&shard] { return shard->Pending.empty() && !shard->Busy; });
+		}
+	}
+
+	inline int ShardIndex(int key) const {
+		if (key <= m_MinKey)
+			return 0;
+		if (key >= m_MaxKey)
+			return ShardCount() - 1;
+
+		long long span = static_cast<long long>(m_MaxKey) - m_MinKey + 1;
+		return static_cast<int>((static_cast<long long>(key) - m_MinKey) * ShardCount() / span);
+	}
+
+	inline int ShardVersion(int shard, int epoch) const {
+		return m_Epochs[std::min(std::max(epoch, 0), CurrentEpoch())][shard];
+	}
+
+private:
+	int m_MinKey;
+	int m_MaxKey;
+
+	std::vector<std::unique_ptr<Shard>> m_Shards;
+	std::vector<std::vector<int>> m_Epochs;
+};
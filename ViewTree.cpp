@@ -22,6 +22,7 @@ void viewTree()
 	std::cout << "rem <key> - Remove key\n";
 	std::cout << "imp [version] - Print tree\n";
 	std::cout << "suc <key> <version> - Print successor of key\n";
+	std::cout << "cmp [version] - Compact nodes in the order of version\n";
 
 	RBTree tree;
 
@@ -87,6 +88,14 @@ void viewTree()
 			int successor = tree.Successor(key, version);
 			std::cout << "\n\n Successor: " << (successor == INT32_MAX ? "Infinity" : std::to_string(successor)) << "\n\n";
 		}
+		else if (tokens.front() == "cmp")
+		{
+			int version = tokens.size() > 1 ? std::stoi(tokens[1]) : tree.CurrentVersion();
+			RBTree::CompactionReport report = tree.Compact(version);
+			std::cout << "\n\n Compacted " << report.Nodes << " nodes: " << report.BytesBefore << " -> " << report.BytesAfter
+				<< " bytes (" << report.BytesSaved << " saved), " << report.CacheLinesPerSearchBefore << " -> " << report.CacheLinesPerSearchAfter
+				<< " cache lines and " << report.PagesPerSearchBefore << " -> " << report.PagesPerSearchAfter << " pages per search\n\n";
+		}
 		else
 			std::cerr << "Error: Unknown command " << tokens.front() << std::endl;
 	}
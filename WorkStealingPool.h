@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool where every thread owns a deque of tasks. A thread pushes
+// and pops its own tasks at the back and idle threads steal from the front
+// of the others. Threads outside the pool share one extra deque.
+class WorkStealingPool {
+public:
+	inline explicit WorkStealingPool(int threadCount = static_cast<int>(std::thread::hardware_concurrency())) {
+		threadCount = std::max(threadCount, 1);
+
+		for (int i = 0; i <= threadCount; i++)
+			m_Deques.emplace_back(new TaskDeque());
+		for (int i = 0; i < threadCount; i++)
+			m_Workers.emplace_back(&WorkStealingPool::Work, this, i);
+	}
+
+	inline ~WorkStealingPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Stopping = true;
+		}
+		m_Sleep.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	// Runs first and second, possibly in parallel, and returns when both
+	// have finished. While waiting for a stolen task the caller runs others.
+	template <typename First, typename Second>
+	inline void Invoke(First&& first, Second&& second) {
+		Task task(std::forward<First>(first));
+		TaskDeque& deque = *m_Deques[OwnDequeIndex()];
+		{
+			std::lock_guard<std::mutex> lock(deque.Mutex);
+			deque.Tasks.push_back(&task);
+		}
+		m_Queued++;
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+		}
+		m_Sleep.notify_one();
+
+		second();
+
+		if (PopBack(deque, &task))
+			task.Run();
+
+		while (!task.Done.load(std::memory_order_acquire)) {
+			if (!RunOneTask())
+				std::this_thread::yield();
+		}
+	}
+
+private:
+	struct Task {
+		std::function<void()> Work;
+		std::atomic<bool> Done{ false };
+
+		template <typename Function>
+		inline explicit Task(Function&& work) : Work(std::forward<Function>(work)) {}
+
+		inline void Run() {
+			Work();
+			Done.store(true, std::memory_order_release);
+		}
+	};
+
+	struct TaskDeque {
+		std::mutex Mutex;
+		std::deque<Task*> Tasks;
+	};
+
+	inline void Work(int index) {
+		t_Pool = this;
+		t_DequeIndex = index;
+
+		while (true) {
+			if (RunOneTask())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_Sleep.wait(lock, [this] { return m_Stopping || m_Queued > 0; });
+			if (m_Stopping)
+				return;
+		}
+	}
+
+	// Pops the newest task of the own deque or steals the oldest of another.
+	inline bool RunOneTask() {
+		std::size_t own = OwnDequeIndex();
+		for (std::size_t i = 0; i < m_Deques.size(); i++) {
+			std::size_t index = (own + i) % m_Deques.size();
+			Task* task = i == 0 ? PopBack(*m_Deques[index], nullptr) : PopFront(*m_Deques[index]);
+			if (task) {
+				task->Run();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Pops the back task, only if it is expected when expected is not null.
+	inline Task* PopBack(TaskDeque& deque, Task* expected) {
+		std::lock_guard<std::mutex> lock(deque.Mutex);
+		if (deque.Tasks.empty() || (expected && deque.Tasks.back() != expected))
+			return nullptr;
+
+		Task* task = deque.Tasks.back();
+		deque.Tasks.pop_back();
+		m_Queued--;
+		return task;
+	}
+
+	inline Task* PopFront(TaskDeque& deque) {
+		std::lock_guard<std::mutex> lock(deque.Mutex);
+		if (deque.Tasks.empty())
+			return nullptr;
+
+		Task* task = deque.Tasks.front();
+		deque.Tasks.pop_front();
+		m_Queued--;
+		return task;
+	}
+
+	inline std::size_t OwnDequeIndex() const {
+		return t_Pool == this ? t_DequeIndex : m_Deques.size() - 1;
+	}
+
+private:
+	std::vector<std::unique_ptr<TaskDeque>> m_Deques;
+	std::vector<std::thread> m_Workers;
+
+	std::atomic<int> m_Queued{ 0 };
+	std::mutex m_SleepMutex;
+	std::condition_variable m_Sleep;
+	bool m_Stopping{ false };
+
+	static thread_local WorkStealingPool* t_Pool;
+	static thread_local std::size_t t_DequeIndex;
+};
+
+inline thread_local WorkStealingPool* WorkStealingPool::t_Pool = nullptr;
+inline thread_local std::size_t WorkStealingPool::t_DequeIndex = 0;
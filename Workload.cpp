@@ -0,0 +1,497 @@
+#include "RBTreeFileHandler.h"
+#include "PathRBTree.h"
+#include "ShardedRBTree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+
+// Every allocation carries a small header with its size so the replayer can
+// report how many live bytes the tree holds after each thousand versions.
+// Counting is turned off for the replayer's own bookkeeping and for the
+// multithreaded benchmarks, where the shared counter would serialize the
+// allocations. The header remembers whether the block was counted.
+static std::atomic<long long> s_LiveBytes{ 0 };
+static bool s_CountAllocations = true;
+
+struct alignas(std::max_align_t) AllocationHeader
+{
+	std::size_t Size;
+	bool Counted;
+};
+
+void* operator new(std::size_t size)
+{
+	AllocationHeader* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+	if (!header)
+		throw std::bad_alloc();
+
+	header->Size = size;
+	header->Counted = s_CountAllocations;
+	if (header->Counted)
+		s_LiveBytes += size;
+	return header + 1;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	if (!pointer)
+		return;
+
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer) - sizeof(AllocationHeader);
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(address);
+	if (header->Counted)
+		s_LiveBytes -= header->Size;
+	std::free(header);
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+class Arguments
+{
+public:
+	// Only the given keys are accepted, so a mistyped option is not ignored.
+	inline Arguments(int argc, char* argv[], int first, const std::set<std::string>& keys)
+	{
+		for (int i = first; i < argc; i++)
+		{
+			std::string argument(argv[i]);
+			std::size_t equals = argument.find('=');
+			if (equals == std::string::npos)
+			{
+				std::cerr << "Error: Expected key=value argument but got " << argument << std::endl;
+				exit(EXIT_FAILURE);
+			}
+
+			std::string key = argument.substr(0, equals);
+			if (!keys.count(key))
+			{
+				std::cerr << "Error: Unknown argument " << key << " for this mode" << std::endl;
+				exit(EXIT_FAILURE);
+			}
+
+			m_Values[key] = argument.substr(equals + 1);
+		}
+	}
+
+	inline std::string Get(const std::string& key, const std::string& fallback) const
+	{
+		auto value = m_Values.find(key);
+		return value == m_Values.end() ? fallback : value->second;
+	}
+
+	inline long long GetInt(const std::string& key, long long fallback) const { return std::stoll(Get(key, std::to_string(fallback))); }
+	inline double GetDouble(const std::string& key, double fallback) const { return std::stod(Get(key, std::to_string(fallback))); }
+
+private:
+	std::map<std::string, std::string> m_Values;
+};
+
+// Zipfian ranks in [0, n) following Gray et al., "Quickly Generating
+// Billion-Record Synthetic Databases". Ranks are scrambled so the hot keys
+// are spread over the key range instead of clustered at its start.
+class ZipfianGenerator
+{
+public:
+	inline ZipfianGenerator(int n, double theta) : m_N(n), m_Theta(theta)
+	{
+		double zeta2 = 1.0 + std::pow(0.5, theta);
+		for (int i = 1; i <= n; i++)
+			m_ZetaN += 1.0 / std::pow(i, theta);
+
+		m_Alpha = 1.0 / (1.0 - theta);
+		m_Eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / m_ZetaN);
+	}
+
+	inline int Next(std::mt19937_64& random) const
+	{
+		double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+		double uz = u * m_ZetaN;
+
+		long long rank;
+		if (uz < 1.0)
+			rank = 0;
+		else if (uz < 1.0 + std::pow(0.5, m_Theta))
+			rank = 1;
+		else
+			rank = static_cast<long long>(m_N * std::pow(m_Eta * u - m_Eta + 1.0, m_Alpha));
+
+		return static_cast<int>((static_cast<unsigned long long>(rank) * 0x9E3779B97F4A7C15ull) % m_N);
+	}
+
+private:
+	int m_N;
+	double m_Theta;
+	double m_ZetaN{ 0.0 };
+	double m_Alpha;
+	double m_Eta;
+};
+
+class WorkloadGenerator
+{
+public:
+	enum class Distribution { Uniform, Zipfian, Sequential };
+
+	inline WorkloadGenerator(const Arguments& arguments)
+		: m_Operations(arguments.GetInt("ops", 100000)), m_KeyRange(static_cast<int>(arguments.GetInt("range", 1000000))),
+		m_VersionSkew(arguments.GetDouble("skew", 0.0)), m_Random(arguments.GetInt("seed", 42))
+	{
+		ParseMix(arguments.Get("mix", "INC:60,REM:20,SUC:19,IMP:1"));
+
+		std::string keys = arguments.Get("keys", "uniform");
+		if (keys == "uniform")
+			m_Distribution = Distribution::Uniform;
+		else if (keys == "zipf")
+			m_Distribution = Distribution::Zipfian;
+		else if (keys == "seq")
+			m_Distribution = Distribution::Sequential;
+		else
+		{
+			std::cerr << "Error: Unknown key distribution " << keys << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		if (m_KeyRange <= 0 || m_VersionSkew < 0.0)
+		{
+			std::cerr << "Error: range must be positive and skew non negative" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		if (m_Distribution == Distribution::Zipfian)
+			m_Zipfian = new ZipfianGenerator(m_KeyRange, arguments.GetDouble("zipf", 0.99));
+	}
+
+	inline ~WorkloadGenerator() { delete m_Zipfian; }
+
+	void Generate(std::ostream& outStream)
+	{
+		std::discrete_distribution<int> pickCommand(std::begin(m_Weights), std::end(m_Weights));
+
+		for (long long i = 0; i < m_Operations; i++)
+		{
+			switch (pickCommand(m_Random))
+			{
+			case 0:
+				GenerateInsert(outStream);
+				break;
+			case 1:
+				GenerateRemove(outStream);
+				break;
+			case 2:
+				outStream << "SUC " << NextKey() << ' ' << NextVersion() << '\n';
+				break;
+			case 3:
+				outStream << "IMP " << NextVersion() << '\n';
+				break;
+			}
+		}
+	}
+
+private:
+	inline void ParseMix(const std::string& mix)
+	{
+		static const std::string commands[] = { "INC", "REM", "SUC", "IMP" };
+
+		std::stringstream ss(mix);
+		std::string entry;
+		while (std::getline(ss, entry, ','))
+		{
+			std::size_t colon = entry.find(':');
+			auto command = std::find(std::begin(commands), std::end(commands), entry.substr(0, colon));
+			if (colon == std::string::npos || command == std::end(commands))
+			{
+				std::cerr << "Error: Invalid mix entry " << entry << std::endl;
+				exit(EXIT_FAILURE);
+			}
+
+			m_Weights[command - std::begin(commands)] = std::stod(entry.substr(colon + 1));
+		}
+
+		double total = 0.0;
+		for (double weight : m_Weights)
+		{
+			if (weight < 0.0)
+			{
+				std::cerr << "Error: Mix weights must be non negative" << std::endl;
+				exit(EXIT_FAILURE);
+			}
+			total += weight;
+		}
+
+		if (total <= 0.0)
+		{
+			std::cerr << "Error: Mix weights must not all be zero" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// The tree does not support duplicated keys, so a drawn key that is
+	// already present is redrawn a few times and the insert is dropped if
+	// the key range is saturated.
+	inline void GenerateInsert(std::ostream& outStream)
+	{
+		for (int attempt = 0; attempt < 64; attempt++)
+		{
+			int key = m_Distribution == Distribution::Sequential ? m_NextSequentialKey++ % m_KeyRange : NextKey();
+			if (attempt >= 16)
+				key = std::uniform_int_distribution<int>(0, m_KeyRange - 1)(m_Random);
+
+			if (m_LiveKeys.insert(key).second)
+			{
+				m_Version++;
+				outStream << "INC " << key << '\n';
+				return;
+			}
+		}
+	}
+
+	// Removes a live key: the oldest one for sequential keys, otherwise the
+	// first live key at or after a drawn one, so hot keys are removed more.
+	inline void GenerateRemove(std::ostream& outStream)
+	{
+		if (m_LiveKeys.empty())
+			return;
+
+		auto key = m_LiveKeys.begin();
+		if (m_Distribution != Distribution::Sequential)
+		{
+			key = m_LiveKeys.lower_bound(NextKey());
+			if (key == m_LiveKeys.end())
+				key = m_LiveKeys.begin();
+		}
+
+		outStream << "REM " << *key << '\n';
+		m_LiveKeys.erase(key);
+		m_Version++;
+	}
+
+	inline int NextKey()
+	{
+		switch (m_Distribution)
+		{
+		case Distribution::Zipfian:
+			return m_Zipfian->Next(m_Random);
+		case Distribution::Sequential:
+			return std::uniform_int_distribution<int>(0, std::max(m_NextSequentialKey, 1) - 1)(m_Random) % m_KeyRange;
+		default:
+			return std::uniform_int_distribution<int>(0, m_KeyRange - 1)(m_Random);
+		}
+	}
+
+	// skew = 0 picks versions uniformly, larger values concentrate the
+	// accesses on the most recent versions.
+	inline int NextVersion()
+	{
+		double u = std::uniform_real_distribution<double>(0.0, 1.0)(m_Random);
+		return m_Version - static_cast<int>(m_Version * std::pow(u, 1.0 + m_VersionSkew));
+	}
+
+private:
+	long long m_Operations;
+	int m_KeyRange;
+	double m_VersionSkew;
+	double m_Weights[4]{ 0.0, 0.0, 0.0, 0.0 };
+
+	Distribution m_Distribution{ Distribution::Uniform };
+	ZipfianGenerator* m_Zipfian{ nullptr };
+	std::mt19937_64 m_Random;
+
+	std::set<int> m_LiveKeys;
+	int m_NextSequentialKey{ 0 };
+	int m_Version{ 0 };
+};
+
+template <typename TreeType>
+class TraceReplayer
+{
+public:
+	inline TraceReplayer(std::string inputFilePath, std::string outputFilePath) : m_FileHandler(inputFilePath, outputFilePath) {}
+
+	void Replay()
+	{
+		long long baseBytes = s_LiveBytes;
+		int nextSample = 1000;
+
+		std::vector<std::string> tokens;
+		while (m_FileHandler.NextComand(tokens))
+		{
+			auto start = std::chrono::steady_clock::now();
+			bool succeeded = m_FileHandler.ExecComand(tokens);
+			auto end = std::chrono::steady_clock::now();
+			if (!succeeded)
+				return;
+
+			s_CountAllocations = false;
+			m_Latencies[tokens.front()].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+			int version = m_FileHandler.Tree().CurrentVersion();
+			if (version >= nextSample)
+			{
+				m_MemorySamples.emplace_back(version, s_LiveBytes - baseBytes);
+				nextSample = (version / 1000 + 1) * 1000;
+			}
+			s_CountAllocations = true;
+		}
+	}
+
+	void Report(std::ostream& outStream)
+	{
+		outStream << "command,count,p50_ns,p99_ns,p999_ns\n";
+		for (auto& latencies : m_Latencies)
+		{
+			std::vector<long long>& samples = latencies.second;
+			std::sort(samples.begin(), samples.end());
+			outStream << latencies.first << ',' << samples.size() << ',' << Percentile(samples, 0.50) << ','
+				<< Percentile(samples, 0.99) << ',' << Percentile(samples, 0.999) << '\n';
+		}
+
+		outStream << "\nversion,live_bytes,bytes_per_1000_versions\n";
+		long long previousBytes = 0;
+		int previousVersion = 0;
+		for (auto& sample : m_MemorySamples)
+		{
+			long long growth = (sample.second - previousBytes) * 1000 / (sample.first - previousVersion);
+			outStream << sample.first << ',' << sample.second << ',' << growth << '\n';
+			previousBytes = sample.second;
+			previousVersion = sample.first;
+		}
+	}
+
+private:
+	static inline long long Percentile(const std::vector<long long>& sortedSamples, double percentile)
+	{
+		if (sortedSamples.empty())
+			return 0;
+
+		std::size_t rank = static_cast<std::size_t>(std::ceil(percentile * sortedSamples.size()));
+		return sortedSamples[std::min(std::max<std::size_t>(rank, 1), sortedSamples.size()) - 1];
+	}
+
+private:
+	RBTreeFileHandler<TreeType> m_FileHandler;
+
+	std::map<std::string, std::vector<long long>> m_Latencies;
+	std::vector<std::pair<int, long long>> m_MemorySamples;
+};
+
+// Inserts the same uniform keys with 1, 2, 4, ... shards and reports the
+// throughput of each configuration relative to a single shard.
+static void BenchmarkShards(const Arguments& arguments)
+{
+	long long operations = arguments.GetInt("ops", 1000000);
+	int keyRange = static_cast<int>(arguments.GetInt("range", 100000000));
+	int maxShards = static_cast<int>(arguments.GetInt("max", std::max(1u, std::thread::hardware_concurrency())));
+	int batchSize = static_cast<int>(arguments.GetInt("batch", 10000));
+
+	std::mt19937_64 random(arguments.GetInt("seed", 42));
+	std::uniform_int_distribution<int> pickKey(0, keyRange - 1);
+	std::vector<int> keys(operations);
+	for (int& key : keys)
+		key = pickKey(random);
+
+	s_CountAllocations = false;
+
+	std::cout << "shards,ops_per_sec,speedup\n";
+	double baseThroughput = 0.0;
+	for (int shards = 1; shards <= maxShards; shards *= 2)
+	{
+		ShardedRBTree tree(shards, 0, keyRange - 1);
+
+		auto start = std::chrono::steady_clock::now();
+		for (std::size_t first = 0; first < keys.size(); first += batchSize)
+		{
+			std::size_t last = std::min(keys.size(), first + batchSize);
+			tree.InsertBatch(std::vector<int>(keys.begin() + first, keys.begin() + last));
+		}
+		tree.Commit();
+		auto end = std::chrono::steady_clock::now();
+
+		double throughput = operations / std::chrono::duration<double>(end - start).count();
+		if (shards == 1)
+			baseThroughput = throughput;
+
+		std::cout << shards << ',' << static_cast<long long>(throughput) << ',' << throughput / baseThroughput << '\n';
+	}
+}
+
+template <typename TreeType>
+static void Replay(std::string inputFilePath, std::string outputFilePath)
+{
+	TraceReplayer<TreeType> replayer(inputFilePath, outputFilePath);
+	replayer.Replay();
+	replayer.Report(std::cout);
+}
+
+static void PrintUsage()
+{
+	std::cerr << "Usage:" << std::endl;
+	std::cerr << "  Workload gen <output> [ops=100000] [mix=INC:60,REM:20,SUC:19,IMP:1] [keys=uniform|zipf|seq]" << std::endl;
+	std::cerr << "               [range=1000000] [zipf=0.99] [skew=0] [seed=42]" << std::endl;
+	std::cerr << "  Workload replay <input> [output=/dev/null] [engine=rbtree|path]" << std::endl;
+	std::cerr << "  Workload shards [ops=1000000] [range=100000000] [max=<cores>] [batch=10000] [seed=42]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::string mode(argv[1]);
+	if (mode == "shards")
+	{
+		BenchmarkShards(Arguments(argc, argv, 2, { "ops", "range", "max", "batch", "seed" }));
+		return EXIT_SUCCESS;
+	}
+
+	if (argc < 3)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	if (mode == "gen")
+	{
+		std::ofstream outFileStream(argv[2], std::ios::out);
+		if (outFileStream.fail())
+		{
+			std::cerr << "Error: Couldnt open output file " << argv[2] << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		WorkloadGenerator generator(Arguments(argc, argv, 3, { "ops", "mix", "keys", "range", "skew", "seed", "zipf" }));
+		generator.Generate(outFileStream);
+	}
+	else if (mode == "replay")
+	{
+		Arguments arguments(argc, argv, 3, { "engine", "output" });
+		std::string engine = arguments.Get("engine", "rbtree");
+		if (engine == "rbtree")
+			Replay<RBTree>(argv[2], arguments.Get("output", "/dev/null"));
+		else if (engine == "path")
+			Replay<PathRBTree>(argv[2], arguments.Get("output", "/dev/null"));
+		else
+		{
+			std::cerr << "Error: Unknown engine " << engine << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+}